@@ -9,12 +9,18 @@
  *
  * The framework assumes a specific hardware configuration and provides a high-level interface for
  * interacting with the different components of the robot. This includes moving forwards and backwards,
- * turning, measuring distance to obstacles, and adjusting servo positions.
+ * turning, measuring distance to obstacles, and adjusting servo positions. Sketches can also subscribe to
+ * events such as a finished turn or a stalled wheel through the EventController, while the BatteryController
+ * keeps the motor speed constant as the battery discharges. Whenever the framework waits, the PowerController
+ * puts the CPU to sleep.
  */
 
 #ifndef BFEArduinoRobotFramework_h
 #define BFEArduinoRobotFramework_h
 
+#include "PowerController.h"
+#include "EventController.h"
+#include "BatteryController.h"
 #include "MotorController.h"
 #include "UltrasonicSensorController.h"
 #include "ServoController.h"
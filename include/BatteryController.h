@@ -0,0 +1,120 @@
+#ifndef BatteryController_h
+#define BatteryController_h
+
+#include "Arduino.h"
+
+/**
+ * @file BatteryController.h
+ * @class BatteryController
+ * @brief Measures the battery voltage and compensates the motor speed for it.
+ *
+ * Battery sensing is off until begin() is called with the pin of a voltage divider, so robots without one are
+ * not affected. While it is on, this class lets the ADC sample the battery voltage on every Timer0 overflow
+ * (about 1000 times per second), the timer that also drives millis(). The conversion complete interrupt adds up
+ * the samples, so measuring never blocks the sketch. It fires about 104 microseconds after each millis()
+ * interrupt and so wakes a sleeping CPU a second time every millisecond, which is still far less often than free
+ * running at about 9600 samples per second. The measured voltage is used to scale the PWM value of the motors,
+ * so the same speed value drives the wheels equally fast on a full and on an almost empty battery. When the
+ * voltage drops below the low battery voltage, EventController::LOW_BATTERY is emitted.
+ *
+ * @note While battery sensing is on, the ADC is busy all the time, so analogRead() must not be used. end()
+ * gives the ADC back.
+ *
+ * @param nominalVoltage Battery voltage at which the motor speed is not changed.
+ * @param lowVoltage Battery voltage below which the battery counts as low.
+ */
+class BatteryController
+{
+public:
+  static const int SAMPLES_PER_READING = 64; ///< Number of ADC samples that are averaged into one reading.
+
+  /**
+   * Constructor for creating a BatteryController.
+   * Battery sensing stays off until begin() is called.
+   * @param nominalVoltage Battery voltage at which the motor speed is not changed.
+   * @param lowVoltage Battery voltage below which the battery counts as low.
+   */
+  BatteryController(float nominalVoltage, float lowVoltage);
+
+  /**
+   * Resets the measured voltage. Does not touch the ADC.
+   * This method should be called once in the setup() function of the Arduino sketch.
+   */
+  void setup();
+
+  /**
+   * Turns battery sensing and speed compensation on.
+   * The ADC samples the pin on every Timer0 overflow until end() is called.
+   * @param pin Analog pin connected to the battery through a voltage divider.
+   * @param dividerRatio Ratio of the battery voltage to the voltage at the pin (default = 3.0).
+   */
+  void begin(int pin, float dividerRatio = 3.0);
+
+  /**
+   * Turns battery sensing and speed compensation off and restores the ADC, so analogRead() works again.
+   */
+  void end();
+
+  /**
+   * Turns battery sensing and speed compensation on or off.
+   * Turning it on only works after begin() has configured the battery pin.
+   * @param enabled Whether the battery is sampled and the motor speed is scaled with its voltage.
+   */
+  void setCompensation(bool enabled);
+
+  /**
+   * Returns the last measured battery voltage.
+   * @return Battery voltage in volts, 0 until the first reading is complete.
+   */
+  float getVoltage();
+
+  /**
+   * Returns whether the battery voltage is below the low battery voltage.
+   */
+  bool isLowBattery();
+
+  /**
+   * Scales a PWM value so the motor runs as fast as it would at the nominal voltage.
+   * @param speed PWM value between 0 and 255.
+   * @return Compensated PWM value between 0 and 255.
+   */
+  int compensate(int speed);
+
+  /**
+   * Adds one ADC sample of the battery pin. Called by the ADC conversion complete interrupt.
+   * @param sample Raw ADC value between 0 and 1023.
+   */
+  void addSample(unsigned int sample);
+
+  /**
+   * Processes a new reading, if there is one, into voltage, gain and low battery state, and emits
+   * EventController::LOW_BATTERY when the battery became low. Called by EventController::dispatch().
+   */
+  void update();
+
+private:
+  static const int GAIN_ONE = 256; ///< Gain that leaves the speed unchanged, gains are in 1/256 steps.
+
+  int _pin;                                      ///< Analog pin connected to the battery, -1 before begin().
+  float _voltsPerReading;                        ///< Battery voltage per unit of a summed up reading.
+  float _nominalVoltage, _lowVoltage;            ///< Voltage without compensation and low battery voltage.
+  bool _sensing;                                 ///< Whether the battery is sampled and the speed compensated.
+  bool _lowBattery;                              ///< Whether the battery is low.
+  float _voltage;                                ///< Last measured battery voltage.
+  int _gain;                                     ///< Current speed gain in 1/256 steps.
+  volatile unsigned int _sampleSum, _sampleCount; ///< Samples summed up by the interrupt so far.
+  volatile unsigned int _reading;                ///< Last complete sum of SAMPLES_PER_READING samples.
+  volatile bool _readingReady;                   ///< Whether _reading holds a reading that was not processed yet.
+#ifdef __AVR__
+  uint8_t _savedADCSRA, _savedADCSRB, _savedADMUX, _savedDIDR0; ///< ADC registers from before begin().
+#endif
+
+  /**
+   * Forgets the measured voltage and any samples that were not processed yet.
+   */
+  void _resetReadings();
+};
+
+extern BatteryController batteryController;
+
+#endif
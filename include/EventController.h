@@ -0,0 +1,127 @@
+#ifndef EventController_h
+#define EventController_h
+
+#include "Arduino.h"
+
+/**
+ * @file EventController.h
+ * @class EventController
+ * @brief Delivers robot events to callbacks registered by the sketch.
+ *
+ * This class lets a sketch react to things happening on the robot instead of polling for them. The other
+ * controllers emit events (a measured distance, a finished turn or move, a stalled wheel, a low battery) into a
+ * small queue, and dispatch() hands them to the subscribed callbacks from the main loop. Events are never
+ * delivered from inside an interrupt service routine. dispatch() also runs the background checks that emit
+ * events, so DISTANCE_BELOW and LOW_BATTERY fire even if the sketch never measures anything itself.
+ *
+ * Subscriber slots and the event queue are fixed size arrays, so no memory is allocated at runtime.
+ *
+ * @note dispatch() has to be called regularly in the loop() function of the Arduino sketch.
+ */
+class EventController
+{
+public:
+  /**
+   * Events that can be subscribed to.
+   */
+  enum Event
+  {
+    DISTANCE_BELOW, /**< A measured distance is below the subscriber's threshold. Value: distance in centimeters. */
+    TURN_COMPLETE,  /**< A turn has finished. Value: turned degrees, negative for left, fewer on stall. */
+    MOVE_COMPLETE,  /**< A move has finished. Value: moved encoder holes, negative backward, fewer on stall. */
+    WHEEL_STALL,    /**< A powered wheel did not turn in time and was stopped. Value: MotorController::Wheel. */
+    LOW_BATTERY     /**< The battery voltage dropped below the low battery voltage. Value: voltage in millivolts. */
+  };
+
+  /**
+   * Signature of a function that receives events.
+   * @param event The event that occurred.
+   * @param value Event specific value, see Event.
+   */
+  typedef void (*Callback)(Event event, long value);
+
+  static const int MAX_SUBSCRIBERS = 8;    ///< Number of available subscriber slots.
+  static const int MAX_PENDING_EVENTS = 8; ///< Number of events that can wait for dispatch().
+
+  /**
+   * Constructor for creating an EventController.
+   * Starts without any subscribers or pending events.
+   */
+  EventController();
+
+  /**
+   * Removes all subscribers and pending events.
+   * This method should be called once in the setup() function of the Arduino sketch.
+   */
+  void setup();
+
+  /**
+   * Registers a callback for an event.
+   * @param event Event to subscribe to.
+   * @param callback Function that is called when the event is dispatched.
+   * @param threshold Only used by DISTANCE_BELOW: distance in centimeters below which the callback is called.
+   * @return Id of the subscription for unsubscribe(), or -1 if all slots are in use.
+   */
+  int subscribe(Event event, Callback callback, long threshold = 0);
+
+  /**
+   * Removes a subscription.
+   * @param id Id returned by subscribe().
+   */
+  void unsubscribe(int id);
+
+  /**
+   * Queues an event for the next dispatch().
+   * Events nobody would receive are dropped right away. If the queue is full, the oldest event is dropped.
+   * @param event Event that occurred.
+   * @param value Event specific value, see Event.
+   */
+  void emit(Event event, long value = 0);
+
+  /**
+   * Returns whether any callback is subscribed to an event.
+   * @param event Event to check.
+   */
+  bool isSubscribed(Event event);
+
+  /**
+   * Runs the background checks and calls the subscribed callbacks for all queued events.
+   * The battery is checked with BatteryController::update(), and while DISTANCE_BELOW is subscribed, the
+   * distance is measured with UltrasonicSensorController::update().
+   * Should be called regularly in the loop() function of the Arduino sketch.
+   */
+  void dispatch();
+
+private:
+  /**
+   * A registered callback.
+   */
+  struct Subscriber
+  {
+    Event event;       ///< Subscribed event.
+    Callback callback; ///< Function to call, nullptr for a free slot.
+    long threshold;    ///< Threshold for DISTANCE_BELOW.
+  };
+
+  /**
+   * An event waiting for dispatch().
+   */
+  struct PendingEvent
+  {
+    Event event; ///< Event that occurred.
+    long value;  ///< Event specific value.
+  };
+
+  Subscriber _subscribers[MAX_SUBSCRIBERS];         ///< Subscriber slots.
+  PendingEvent _pendingEvents[MAX_PENDING_EVENTS]; ///< Ring buffer of queued events.
+  int _pendingHead, _pendingCount;                 ///< Index of the oldest queued event and number of queued events.
+
+  /**
+   * Checks whether a subscriber wants to receive an event.
+   */
+  bool _matches(const Subscriber &subscriber, Event event, long value);
+};
+
+extern EventController eventController;
+
+#endif
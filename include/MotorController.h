@@ -2,6 +2,7 @@
 #define MotorController_h
 
 #include "Arduino.h"
+#include "EventController.h"
 
 /**
  * @file MotorController.h
@@ -10,7 +11,9 @@
  *
  * This class provides an interface for controlling the robot equipped with left and right motors, including
  * functions for moving forward, backward, stopping, and turning. It utilizes encoder feedback to
- * maintain speed and direction accuracy.
+ * maintain speed and direction accuracy. A wheel that gets power but doesn't turn is detected as stalled, gets
+ * stopped and is reported as EventController::WHEEL_STALL. The PWM values are scaled with the battery voltage
+ * by the BatteryController. While waiting for the wheels, the CPU sleeps through the PowerController.
  *
  * @note This class is designed to be used with Arduino-based controllers.
  *
@@ -51,6 +54,15 @@ public:
     NONE = 0       /**< Indicates no movement. */
   };
 
+  /**
+   * Wheels of the robot, used as value of EventController::WHEEL_STALL.
+   */
+  enum Wheel
+  {
+    LEFT = 0, /**< The left wheel. */
+    RIGHT = 1 /**< The right wheel. */
+  };
+
   /**
    * Initializes the motor controller by setting up pin modes and attaching interrupts for the speed sensors.
    */
@@ -68,6 +80,13 @@ public:
    */
   void setSpeed(int speed);
 
+  /**
+   * Sets the minimum time a powered wheel may go without an encoder hole before it counts as stalled.
+   * At low speeds the timeout grows with the expected time between two holes.
+   * @param milliseconds Minimum stall timeout in milliseconds (default = 200).
+   */
+  void setStallTimeout(unsigned long milliseconds);
+
   /**
    * Turns the robot left by a specified number of degrees at a certain speed.
    * @param degrees Angle in degrees to turn.
@@ -81,6 +100,13 @@ public:
    */
   void rightTurn(int degrees, int speed = 150);
 
+  /**
+   * Moves the robot straight by a specified number of encoder holes at a certain speed.
+   * @param holes Number of encoder holes to move. Negative values move backward.
+   * @param speed Speed at which to move (default = 150).
+   */
+  void move(int holes, int speed = 150);
+
   /**
    * Updates the speed and direction of the motors based on encoder feedback and desired settings.
    * Should be called regularly to maintain accurate control.
@@ -88,6 +114,10 @@ public:
   void drive();
 
 private:
+#ifdef UNIT_TEST
+  friend struct MotorControllerTestAccess; ///< Gives the native unit tests access to the internal state.
+#endif
+
   int _maxHoles;                                                        ///< Number of holes in the wheel encoder disk.
   float _maxWheelTurnPerSecond;                                         ///< Maximum speed of the wheel in turns per second.
   int _baseSpeed;                                                       ///< Base speed of the robot.
@@ -99,6 +129,10 @@ private:
   volatile int _speedSensorLeftCount, _speedSensorRightCount;           ///< Speed sensor hole counts.
   int _speedSensorLeftCountPrevious, _speedSensorRightCountPrevious;    ///< Previous speed sensor hole counts.
   int _leftMotorSpeed, _rightMotorSpeed;                                ///< Current motor speeds.
+  int _leftWheelPwm, _rightWheelPwm;                                    ///< PWM currently applied to the wheels, negative backward.
+  volatile unsigned long _speedSensorLeftTime, _speedSensorRightTime;   ///< Time of the last speed sensor hole.
+  bool _leftWheelStalled, _rightWheelStalled;                           ///< Whether a wheel was stopped due to a stall.
+  unsigned long _minStallTimeout;                                       ///< Minimum stall timeout in milliseconds.
   unsigned long _previousTime;
   ///< Previous time for speed calculations.
   /**
@@ -116,6 +150,19 @@ private:
    * @param speed Speed at which to turn (default = 150).
    */
   void _turn(int degrees, int speed = 150);
+  /**
+   * Calculates how many encoder holes each wheel has to turn for the robot to turn by the given degrees.
+   * @param degrees Angle in degrees to turn (0 to 360).
+   */
+  int _holesForDegrees(int degrees);
+  /**
+   * Calculates how many degrees the robot turns when each wheel turns by the given number of encoder holes.
+   */
+  int _degreesForHoles(int holes);
+  /**
+   * Returns how many encoder holes the wheels turned on average since the given counts, at most numberHoles.
+   */
+  int _holesMoved(int numberHoles, int currentNumberHolesLeft, int currentNumberHolesRight);
   /**
    * Stops the left wheel.
    */
@@ -156,6 +203,18 @@ private:
    * Calculates the speed error of the robot.
    */
   void _calcSpeedError();
+  /**
+   * Clears the speed error and starts the next speed measurement from the current hole counts.
+   */
+  void _resetSpeedError();
+  /**
+   * Calculates how long a wheel driven with the given PWM may go without an encoder hole.
+   */
+  unsigned long _stallTimeout(int pwm);
+  /**
+   * Stops and reports wheels that get power but stopped turning.
+   */
+  void _checkStall();
 
   /**
    * Interrupt service routine for the left speed sensor.
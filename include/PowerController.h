@@ -0,0 +1,91 @@
+#ifndef PowerController_h
+#define PowerController_h
+
+#include "Arduino.h"
+
+/**
+ * @file PowerController.h
+ * @class PowerController
+ * @brief Puts the CPU to sleep while the framework waits and keeps track of the time spent asleep.
+ *
+ * The framework waits in several places: for the wheels during a turn or move, for the servo to reach its
+ * angle and for the echo of the ultrasonic sensor. Instead of spinning in a busy loop, these waits call idle(),
+ * which sleeps the CPU until the next interrupt. The millis() timer, the speed sensors, the echo pin and the
+ * battery ADC all wake the CPU again, so waits end just as they would without sleeping.
+ *
+ * Only the idle sleep mode is used: the deeper modes stop the timers that generate the motor PWM and the servo
+ * pulses.
+ *
+ * The interrupt that wakes the CPU runs before idle() can read the time again, so its run time is counted as
+ * sleep. The busy time is therefore a lower bound, short by the time spent in interrupts that ended a sleep.
+ *
+ * @note On boards other than AVR, idle() returns immediately and no sleep time is recorded.
+ */
+class PowerController
+{
+public:
+  /**
+   * Constructor for creating a PowerController.
+   * Sleeping is enabled by default.
+   */
+  PowerController();
+
+  /**
+   * Selects the idle sleep mode and starts the time accounting.
+   * This method should be called once in the setup() function of the Arduino sketch.
+   */
+  void setup();
+
+  /**
+   * Enables or disables sleeping while waiting.
+   * @param enabled Whether idle() puts the CPU to sleep (default = true).
+   */
+  void setSleep(bool enabled);
+
+  /**
+   * Sleeps the CPU until the next interrupt.
+   * Call this in a loop that waits for something an interrupt or the passing time will change.
+   */
+  void idle();
+
+  /**
+   * Waits for a number of milliseconds while sleeping the CPU.
+   * Can be used instead of the Arduino delay() function.
+   * @param milliseconds Time to wait in milliseconds.
+   */
+  void delay(unsigned long milliseconds);
+
+  /**
+   * Returns the time the CPU was asleep since setup() or resetStatistics().
+   * @return Sleep time in milliseconds.
+   */
+  unsigned long getSleepMillis();
+
+  /**
+   * Returns the time the CPU was awake since setup() or resetStatistics().
+   * Interrupts that woke the CPU count as sleep, so the real busy time can be somewhat higher.
+   * @return Busy time in milliseconds.
+   */
+  unsigned long getBusyMillis();
+
+  /**
+   * Restarts the sleep and busy time accounting.
+   */
+  void resetStatistics();
+
+private:
+  bool _sleep;                ///< Whether idle() puts the CPU to sleep.
+  unsigned long _startTime;   ///< Time in milliseconds when the accounting started.
+  unsigned long _sleepMillis; ///< Whole milliseconds spent asleep.
+  unsigned long _sleepMicros; ///< Microseconds spent asleep that don't make up a whole millisecond yet.
+
+  /**
+   * Adds the length of one sleep to the sleep time, carrying whole milliseconds over from the microseconds.
+   * @param microseconds Time the CPU was asleep in microseconds.
+   */
+  void _addSleepTime(unsigned long microseconds);
+};
+
+extern PowerController powerController;
+
+#endif
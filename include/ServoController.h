@@ -36,7 +36,7 @@ public:
   /**
    * Sets the servo to a specified angle.
    * The input angle is constrained between 0 and 180 degrees to ensure safe operation.
-   * After setting the angle, the function includes a delay to allow the servo to reach the specified position.
+   * After setting the angle, the function waits with the CPU asleep to allow the servo to reach the specified position.
    *
    * @param angle Desired angle to set the servo. The angle is constrained between 0 and 180 degrees (default is 90°).
    */
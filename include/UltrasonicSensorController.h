@@ -12,8 +12,16 @@
  * It provides an interface to initialize the sensor and to calculate the distance to an object by emitting
  * ultrasonic waves and measuring the time it takes for the echo to return.
  *
+ * On AVR boards with the echo pin on pins 8 to 13, the echo pulse is timed by a pin change interrupt, so the CPU
+ * can sleep while waiting for it. Other echo pins are timed with pulseIn(). With the pin change interrupt,
+ * update() also measures in the background without blocking, so EventController::DISTANCE_BELOW is emitted
+ * even if the sketch never calls getDistance().
+ *
  * @note The setup() method should be called during the Arduino sketch's setup phase to correctly initialize
  * the sensor pins.
+ * @note The PCINT0 pin change interrupt vector is defined by this class. Sketches that use a library which also
+ * defines it (like SoftwareSerial) have to build with BFE_NO_PIN_CHANGE_INTERRUPT defined, which falls back to
+ * pulseIn().
  *
  * @param echo The digital pin number connected to the echo pin of the ultrasonic sensor.
  * @param trig The digital pin number connected to the trigger pin of the ultrasonic sensor.
@@ -38,14 +46,51 @@ public:
   /**
    * Measures the distance to an object in front of the ultrasonic sensor.
    * This function triggers an ultrasonic pulse and measures the time taken for the echo to return,
-   * calculating the distance based on the speed of sound.
+   * calculating the distance based on the speed of sound. The result is also emitted as
+   * EventController::DISTANCE_BELOW, unless there was no echo.
    *
    * @return The measured distance in centimeters.
    */
   unsigned long getDistance();
 
+  /**
+   * Measures the distance in the background and emits EventController::DISTANCE_BELOW for every echo.
+   * Finishes the last measurement and starts a new one every 60 milliseconds without waiting for the echo.
+   * Only works if the echo pulse is timed by the pin change interrupt. Called by EventController::dispatch()
+   * while DISTANCE_BELOW is subscribed.
+   */
+  void update();
+
+  /**
+   * Interrupt service routine for the echo pin. Called by the pin change interrupt.
+   */
+  static void echoChanged_ISR();
+
 private:
-  int _echo, _trig; ///< Pin numbers for echo and trig pins of the ultrasonic sensor
+#ifdef UNIT_TEST
+  friend struct UltrasonicSensorControllerTestAccess; ///< Gives the native unit tests access to the internal state.
+#endif
+
+  int _echo, _trig;                          ///< Pin numbers for echo and trig pins of the ultrasonic sensor
+  bool _echoInterrupt;                       ///< Whether the echo pulse is timed by the pin change interrupt.
+  volatile bool _echoStarted, _echoComplete; ///< Whether the echo pulse has started and ended.
+  volatile unsigned long _echoStart;         ///< Time in microseconds when the echo pulse started.
+  volatile unsigned long _echoDuration;      ///< Length of the last echo pulse in microseconds.
+  bool _measuring;                           ///< Whether update() waits for the echo of a measurement.
+  unsigned long _measureStart;               ///< Time in microseconds when update() started the last measurement.
+
+  /**
+   * Waits until the echo pulse has ended, sleeping the CPU in between.
+   * @return Length of the echo pulse in microseconds, 0 if there was no echo within a second.
+   */
+  unsigned long _waitForEcho();
+
+  /**
+   * Converts an echo pulse into a distance and emits it, unless there was no echo.
+   * @param duration Length of the echo pulse in microseconds, 0 if there was no echo.
+   * @return The distance in centimeters.
+   */
+  unsigned long _reportDistance(unsigned long duration);
 };
 
 #endif
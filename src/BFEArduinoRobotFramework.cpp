@@ -29,10 +29,17 @@ const int speedSensorRight = 3; // Pin number for the right speed sensor
 const int trig = 4; // Pin number connected to the trigger pin of the ultrasonic sensor
 const int echo = 9; // Pin number connected to the echo pin of the ultrasonic sensor
 
+// Battery
+const float batteryNominalVoltage = 7.4; // Battery voltage at which the motor speed is not changed
+const float batteryLowVoltage = 6.6; // Battery voltage below which the battery counts as low
+
 // Servo Motor
 const int servoPin = 7; // Pin number where the servo is connected
 
 // Classes
+PowerController powerController;
+EventController eventController;
+BatteryController batteryController(batteryNominalVoltage, batteryLowVoltage);
 ServoController servoController(servoPin);
 UltrasonicSensorController sensorController(echo, trig);
 MotorController motorController(motorLeftPin1, motorLeftPin2, motorRightPin1, motorRightPin2, speedSensorLeft, speedSensorRight, enA, enB);
@@ -40,6 +47,9 @@ MotorController motorController(motorLeftPin1, motorLeftPin2, motorRightPin1, mo
 void arduinoSetup()
 {
     Serial.begin(9600);
+    powerController.setup();
+    eventController.setup();
+    batteryController.setup();
     servoController.setup();
     sensorController.setup();
     motorController.setup();
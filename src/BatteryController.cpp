@@ -0,0 +1,156 @@
+#include "BatteryController.h"
+#include "EventController.h"
+
+BatteryController *batteryControllerInstance;
+
+const float minimumVoltage = 1.0;        // Below this the voltage divider is assumed to be disconnected
+const float lowVoltageHysteresis = 0.2; // Voltage the battery has to recover before it counts as low again
+
+BatteryController::BatteryController(float nominalVoltage, float lowVoltage)
+{
+  _pin = -1;
+  _voltsPerReading = 0;
+  _nominalVoltage = nominalVoltage;
+  _lowVoltage = lowVoltage;
+  _sensing = false;
+  _resetReadings();
+  batteryControllerInstance = this;
+}
+
+void BatteryController::setup()
+{
+  _resetReadings();
+}
+
+void BatteryController::begin(int pin, float dividerRatio)
+{
+  setCompensation(false);
+  _pin = pin;
+  _voltsPerReading = 5.0 / 1023.0 / SAMPLES_PER_READING * dividerRatio;
+  setCompensation(true);
+}
+
+void BatteryController::end()
+{
+  setCompensation(false);
+}
+
+void BatteryController::setCompensation(bool enabled)
+{
+  if (enabled == _sensing || (enabled && _pin < 0))
+    return;
+
+#ifdef __AVR__
+  if (enabled)
+  {
+    _savedADCSRA = ADCSRA;
+    _savedADCSRB = ADCSRB;
+    _savedADMUX = ADMUX;
+    _savedDIDR0 = DIDR0;
+  }
+  else
+  {
+    // Disable the interrupt and auto trigger first, so no conversion of the battery pin follows
+    ADCSRA = _savedADCSRA;
+    ADCSRB = _savedADCSRB;
+    ADMUX = _savedADMUX;
+    DIDR0 = _savedDIDR0;
+  }
+#endif
+
+  _sensing = enabled;
+  _resetReadings();
+
+#ifdef __AVR__
+  if (enabled)
+  {
+    uint8_t channel = _pin >= A0 ? _pin - A0 : _pin;
+    DIDR0 |= _BV(channel);
+    ADMUX = _BV(REFS0) | (channel & 0x07);
+    // Start a conversion on every Timer0 overflow instead of free running at about 9600 samples per second. The
+    // conversion complete interrupt still wakes a sleeping CPU once per millisecond, about 104us after millis() does
+    ADCSRB = _BV(ADTS2);
+    ADCSRA = _BV(ADEN) | _BV(ADATE) | _BV(ADIE) | _BV(ADPS2) | _BV(ADPS1) | _BV(ADPS0) | _BV(ADSC);
+  }
+#endif
+}
+
+float BatteryController::getVoltage()
+{
+  update();
+  return _voltage;
+}
+
+bool BatteryController::isLowBattery()
+{
+  update();
+  return _lowBattery;
+}
+
+int BatteryController::compensate(int speed)
+{
+  update();
+  if (!_sensing)
+    return speed;
+  long compensated = (static_cast<long>(speed) * _gain) >> 8;
+  return constrain(compensated, 0, 255);
+}
+
+void BatteryController::addSample(unsigned int sample)
+{
+  _sampleSum += sample;
+  if (++_sampleCount < SAMPLES_PER_READING)
+    return;
+  _reading = _sampleSum;
+  _readingReady = true;
+  _sampleSum = 0;
+  _sampleCount = 0;
+}
+
+void BatteryController::update()
+{
+  noInterrupts();
+  bool readingReady = _readingReady;
+  unsigned int reading = _reading;
+  _readingReady = false;
+  interrupts();
+
+  if (!readingReady || !_sensing)
+    return;
+
+  _voltage = reading * _voltsPerReading;
+  if (_voltage < minimumVoltage)
+  {
+    _gain = GAIN_ONE;
+    return;
+  }
+
+  _gain = constrain(static_cast<int>(_nominalVoltage / _voltage * GAIN_ONE), GAIN_ONE / 2, GAIN_ONE * 3 / 2);
+
+  if (!_lowBattery && _voltage < _lowVoltage)
+  {
+    _lowBattery = true;
+    eventController.emit(EventController::LOW_BATTERY, static_cast<long>(_voltage * 1000));
+  }
+  else if (_lowBattery && _voltage > _lowVoltage + lowVoltageHysteresis)
+    _lowBattery = false;
+}
+
+void BatteryController::_resetReadings()
+{
+  noInterrupts();
+  _sampleSum = 0;
+  _sampleCount = 0;
+  _readingReady = false;
+  interrupts();
+  _lowBattery = false;
+  _voltage = 0;
+  _gain = GAIN_ONE;
+}
+
+#ifdef __AVR__
+ISR(ADC_vect)
+{
+  batteryControllerInstance->addSample(ADC);
+}
+#endif
@@ -0,0 +1,101 @@
+#include "EventController.h"
+#include "BFEArduinoRobotFramework.h"
+
+EventController::EventController()
+{
+  setup();
+}
+
+void EventController::setup()
+{
+  for (int i = 0; i < MAX_SUBSCRIBERS; i++)
+    _subscribers[i].callback = nullptr;
+  _pendingHead = 0;
+  _pendingCount = 0;
+}
+
+int EventController::subscribe(Event event, Callback callback, long threshold)
+{
+  if (callback == nullptr)
+    return -1;
+
+  for (int i = 0; i < MAX_SUBSCRIBERS; i++)
+  {
+    if (_subscribers[i].callback != nullptr)
+      continue;
+    _subscribers[i].event = event;
+    _subscribers[i].callback = callback;
+    _subscribers[i].threshold = threshold;
+    return i;
+  }
+  return -1;
+}
+
+void EventController::unsubscribe(int id)
+{
+  if (id < 0 || id >= MAX_SUBSCRIBERS)
+    return;
+  _subscribers[id].callback = nullptr;
+}
+
+void EventController::emit(Event event, long value)
+{
+  bool wanted = false;
+  for (int i = 0; i < MAX_SUBSCRIBERS && !wanted; i++)
+    wanted = _matches(_subscribers[i], event, value);
+  if (!wanted)
+    return;
+
+  if (_pendingCount == MAX_PENDING_EVENTS)
+  {
+    _pendingHead = (_pendingHead + 1) % MAX_PENDING_EVENTS;
+    _pendingCount--;
+  }
+
+  int index = (_pendingHead + _pendingCount) % MAX_PENDING_EVENTS;
+  _pendingEvents[index].event = event;
+  _pendingEvents[index].value = value;
+  _pendingCount++;
+}
+
+bool EventController::isSubscribed(Event event)
+{
+  for (int i = 0; i < MAX_SUBSCRIBERS; i++)
+  {
+    if (_subscribers[i].callback != nullptr && _subscribers[i].event == event)
+      return true;
+  }
+  return false;
+}
+
+void EventController::dispatch()
+{
+  batteryController.update();
+  if (isSubscribed(DISTANCE_BELOW))
+    sensorController.update();
+
+  // Events emitted by a callback are delivered on the next dispatch() so a callback can't keep us here forever.
+  int count = _pendingCount;
+  while (count > 0 && _pendingCount > 0)
+  {
+    PendingEvent pending = _pendingEvents[_pendingHead];
+    _pendingHead = (_pendingHead + 1) % MAX_PENDING_EVENTS;
+    _pendingCount--;
+    count--;
+
+    for (int i = 0; i < MAX_SUBSCRIBERS; i++)
+    {
+      if (_matches(_subscribers[i], pending.event, pending.value))
+        _subscribers[i].callback(pending.event, pending.value);
+    }
+  }
+}
+
+bool EventController::_matches(const Subscriber &subscriber, Event event, long value)
+{
+  if (subscriber.callback == nullptr || subscriber.event != event)
+    return false;
+  if (event == DISTANCE_BELOW)
+    return value < subscriber.threshold;
+  return true;
+}
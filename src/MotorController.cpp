@@ -1,6 +1,8 @@
 #include "Arduino.h"
 #include "Print.h"
 #include "MotorController.h"
+#include "BatteryController.h"
+#include "PowerController.h"
 
 MotorController *motorControllerInstance;
 
@@ -22,6 +24,7 @@ MotorController::MotorController(int motorLeftPin1, int motorLeftPin2, int motor
   _enB = enB;
   _maxHoles = 20;
   _maxWheelTurnPerSecond = 5.0;
+  _minStallTimeout = 200;
   motorControllerInstance = this;
 }
 
@@ -40,9 +43,13 @@ void MotorController::setup()
 
   _leftMotorSpeed = 0;
   _rightMotorSpeed = 0;
+  _leftWheelPwm = 0;
+  _rightWheelPwm = 0;
+  _leftWheelStalled = false;
+  _rightWheelStalled = false;
   _direction = NONE;
   _baseSpeed = 150;
-  _speedError = 0;
+  _resetSpeedError();
 }
 
 void MotorController::setDirection(Direction direction)
@@ -52,6 +59,11 @@ void MotorController::setDirection(Direction direction)
     _stopLeftWheel();
     _stopRightWheel();
   }
+  // The error built up against a stalled wheel would pin the motor speeds after recovering
+  if (_leftWheelStalled || _rightWheelStalled)
+    _resetSpeedError();
+  _leftWheelStalled = false;
+  _rightWheelStalled = false;
   _direction = direction;
 }
 
@@ -60,6 +72,11 @@ void MotorController::setSpeed(int speed)
   _baseSpeed = abs(speed);
 }
 
+void MotorController::setStallTimeout(unsigned long milliseconds)
+{
+  _minStallTimeout = milliseconds;
+}
+
 void MotorController::_stop()
 {
   setDirection(NONE);
@@ -75,6 +92,37 @@ void MotorController::rightTurn(int degrees, int speed)
   _turn(degrees, speed);
 }
 
+void MotorController::move(int holes, int speed)
+{
+  if (speed == 0)
+  {
+    _stop();
+    return;
+  }
+
+  if (holes == 0)
+    return;
+
+  bool isBackward = holes < 0;
+  holes = abs(holes);
+  speed = abs(speed);
+
+  _stop();
+
+  int wheelSpeed = isBackward ? -speed : speed;
+  _setSpeedLeftWheel(wheelSpeed);
+  _setSpeedRightWheel(wheelSpeed);
+
+  int curSpeedCounterLeft = _speedSensorLeftCount;
+  int curSpeedCounterRight = _speedSensorRightCount;
+  _waitForWheelsHolesCount(holes, curSpeedCounterLeft, holes, curSpeedCounterRight);
+
+  if (_leftWheelStalled || _rightWheelStalled)
+    holes = _holesMoved(holes, curSpeedCounterLeft, curSpeedCounterRight);
+
+  eventController.emit(EventController::MOVE_COMPLETE, isBackward ? -holes : holes);
+}
+
 void MotorController::_turn(int degrees, int speed)
 {
   if (speed == 0)
@@ -90,9 +138,7 @@ void MotorController::_turn(int degrees, int speed)
 
   degrees = abs(degrees);
   degrees = constrain(degrees, 0, 360);
-  float rotationInPercent = degrees / 360.0;
-  int fullRotation = _maxHoles * 2;
-  int neededHoles = round(fullRotation * rotationInPercent);
+  int neededHoles = _holesForDegrees(degrees);
 
   if (debugShowTurn)
   {
@@ -114,6 +160,31 @@ void MotorController::_turn(int degrees, int speed)
 
   if (debugShowTurn)
     Serial.println(isLeftTurn ? "End Left Turn" : "End Right Turn");
+
+  if (_leftWheelStalled || _rightWheelStalled)
+    degrees = _degreesForHoles(_holesMoved(neededHoles, curSpeedCounterLeft, curSpeedCounterRight));
+
+  eventController.emit(EventController::TURN_COMPLETE, isLeftTurn ? -degrees : degrees);
+}
+
+int MotorController::_holesForDegrees(int degrees)
+{
+  float rotationInPercent = degrees / 360.0;
+  int fullRotation = _maxHoles * 2;
+  return round(fullRotation * rotationInPercent);
+}
+
+int MotorController::_degreesForHoles(int holes)
+{
+  int fullRotation = _maxHoles * 2;
+  return round(holes * 360.0 / fullRotation);
+}
+
+int MotorController::_holesMoved(int numberHoles, int currentNumberHolesLeft, int currentNumberHolesRight)
+{
+  int holesLeft = _speedSensorLeftCount - currentNumberHolesLeft;
+  int holesRight = _speedSensorRightCount - currentNumberHolesRight;
+  return min((holesLeft + holesRight) / 2, numberHoles);
 }
 
 void MotorController::_waitForLeftWheelHolesCount(int numberHoles, int currentNumberHoles)
@@ -121,18 +192,20 @@ void MotorController::_waitForLeftWheelHolesCount(int numberHoles, int currentNu
   bool leftReady = false;
   while (!leftReady)
   {
+    _checkStall();
     int speedSensorChangedCountLeft = _speedSensorLeftCount - currentNumberHoles;
     if (debugShowWheelWait)
     {
       Serial.print("Left Wheel Count: ");
       Serial.println(speedSensorChangedCountLeft);
     }
-    if (speedSensorChangedCountLeft >= numberHoles)
+    if (speedSensorChangedCountLeft >= numberHoles || _leftWheelStalled)
     {
       leftReady = true;
       if (debugShowWheelWait)
         Serial.println("Left Wheel Ready");
     }
+    powerController.idle();
   }
 }
 
@@ -141,18 +214,20 @@ void MotorController::_waitForRightWheelHolesCount(int numberHoles, int currentN
   bool rightReady = false;
   while (!rightReady)
   {
+    _checkStall();
     int speedSensorChangedCountRight = _speedSensorRightCount - currentNumberHoles;
     if (debugShowWheelWait)
     {
       Serial.print("Right Wheel Count: ");
       Serial.println(speedSensorChangedCountRight);
     }
-    if (speedSensorChangedCountRight >= numberHoles)
+    if (speedSensorChangedCountRight >= numberHoles || _rightWheelStalled)
     {
       rightReady = true;
       if (debugShowWheelWait)
         Serial.println("Right Wheel Ready");
     }
+    powerController.idle();
   }
 }
 
@@ -162,6 +237,7 @@ void MotorController::_waitForWheelsHolesCount(int numberHolesLeft, int currentN
   bool rightReady = false;
   while (!leftReady || !rightReady)
   {
+    _checkStall();
     int speedSensorChangedCountLeft = _speedSensorLeftCount - currentNumberHolesLeft;
     int speedSensorChangedCountRight = _speedSensorRightCount - currentNumberHolesRight;
     if (debugShowWheelWait)
@@ -171,7 +247,7 @@ void MotorController::_waitForWheelsHolesCount(int numberHolesLeft, int currentN
       Serial.print(" | Right Wheel Count: ");
       Serial.println(speedSensorChangedCountRight);
     }
-    if (!leftReady && speedSensorChangedCountLeft >= numberHolesLeft)
+    if (!leftReady && (speedSensorChangedCountLeft >= numberHolesLeft || _leftWheelStalled))
     {
       _stopLeftWheel();
       leftReady = true;
@@ -179,13 +255,14 @@ void MotorController::_waitForWheelsHolesCount(int numberHolesLeft, int currentN
         Serial.println("Left Wheel Ready");
     }
 
-    if (!rightReady && speedSensorChangedCountRight >= numberHolesRight)
+    if (!rightReady && (speedSensorChangedCountRight >= numberHolesRight || _rightWheelStalled))
     {
       _stopRightWheel();
       rightReady = true;
       if (debugShowWheelWait)
         Serial.println("Right Wheel Ready");
     }
+    powerController.idle();
   }
 }
 
@@ -194,6 +271,7 @@ void MotorController::_stopLeftWheel()
   digitalWrite(_motorLeftPin1, 0);
   digitalWrite(_motorLeftPin2, 0);
   analogWrite(_enA, 0);
+  _leftWheelPwm = 0;
 }
 
 void MotorController::_stopRightWheel()
@@ -201,6 +279,7 @@ void MotorController::_stopRightWheel()
   digitalWrite(_motorRightPin1, 0);
   digitalWrite(_motorRightPin2, 0);
   analogWrite(_enB, 0);
+  _rightWheelPwm = 0;
 }
 
 void MotorController::_turnLeftWheel(Direction direction)
@@ -239,14 +318,34 @@ void MotorController::_setSpeedLeftWheel(int speed)
 {
   Direction direction = static_cast<Direction>(constrain(speed, -1, 1));
   _turnLeftWheel(direction);
-  analogWrite(_enA, constrain(abs(speed), 0, 255));
+  int pwm = constrain(speed, -255, 255);
+  analogWrite(_enA, batteryController.compensate(abs(pwm)));
+
+  // A wheel that just got power or changed direction needs time to spin up before it can stall
+  if (pwm != 0 && (_leftWheelPwm == 0 || (pwm < 0) != (_leftWheelPwm < 0)))
+  {
+    noInterrupts();
+    _speedSensorLeftTime = millis();
+    interrupts();
+  }
+  _leftWheelPwm = pwm;
 }
 
 void MotorController::_setSpeedRightWheel(int speed)
 {
   Direction direction = static_cast<Direction>(constrain(speed, -1, 1));
   _turnRightWheel(direction);
-  analogWrite(_enB, constrain(abs(speed), 0, 255));
+  int pwm = constrain(speed, -255, 255);
+  analogWrite(_enB, batteryController.compensate(abs(pwm)));
+
+  // A wheel that just got power or changed direction needs time to spin up before it can stall
+  if (pwm != 0 && (_rightWheelPwm == 0 || (pwm < 0) != (_rightWheelPwm < 0)))
+  {
+    noInterrupts();
+    _speedSensorRightTime = millis();
+    interrupts();
+  }
+  _rightWheelPwm = pwm;
 }
 
 void MotorController::drive()
@@ -254,10 +353,11 @@ void MotorController::drive()
   int curSpeedCounterLeft = _speedSensorLeftCount;
   int curSpeedCounterRight = _speedSensorRightCount;
 
+  _checkStall();
   _calcSpeedError();
 
-  _leftMotorSpeed = constrain(_baseSpeed - _speedError, 100, 255) * _direction;
-  _rightMotorSpeed = constrain(_baseSpeed + _speedError, 100, 255) * _direction;
+  _leftMotorSpeed = _leftWheelStalled ? 0 : constrain(_baseSpeed - _speedError, 100, 255) * _direction;
+  _rightMotorSpeed = _rightWheelStalled ? 0 : constrain(_baseSpeed + _speedError, 100, 255) * _direction;
 
   if (debugShowMotorSpeed)
   {
@@ -324,9 +424,49 @@ void MotorController::_calcSpeedError()
   }
 }
 
+void MotorController::_resetSpeedError()
+{
+  _speedError = 0;
+  _speedSensorLeftCountPrevious = _speedSensorLeftCount;
+  _speedSensorRightCountPrevious = _speedSensorRightCount;
+  _previousTime = millis();
+}
+
+unsigned long MotorController::_stallTimeout(int pwm)
+{
+  // Allow three missed holes at the speed the wheel should reach with this PWM
+  float holesPerSecond = abs(pwm) / 255.0 * _maxWheelTurnPerSecond * _maxHoles;
+  unsigned long timeout = 3000.0 / holesPerSecond;
+  return max(timeout, _minStallTimeout);
+}
+
+void MotorController::_checkStall()
+{
+  noInterrupts();
+  unsigned long leftTime = _speedSensorLeftTime;
+  unsigned long rightTime = _speedSensorRightTime;
+  interrupts();
+  unsigned long currentTime = millis();
+
+  if (_leftWheelPwm != 0 && currentTime - leftTime > _stallTimeout(_leftWheelPwm))
+  {
+    _stopLeftWheel();
+    _leftWheelStalled = true;
+    eventController.emit(EventController::WHEEL_STALL, LEFT);
+  }
+
+  if (_rightWheelPwm != 0 && currentTime - rightTime > _stallTimeout(_rightWheelPwm))
+  {
+    _stopRightWheel();
+    _rightWheelStalled = true;
+    eventController.emit(EventController::WHEEL_STALL, RIGHT);
+  }
+}
+
 void MotorController::_speedCounterLeft_ISR()
 {
   motorControllerInstance->_speedSensorLeftCount++;
+  motorControllerInstance->_speedSensorLeftTime = millis();
   if (debugShowSpeedSensor)
   {
     Serial.print("_speedCounterLeft_ISR: ");
@@ -337,6 +477,7 @@ void MotorController::_speedCounterLeft_ISR()
 void MotorController::_speedCounterRight_ISR()
 {
   motorControllerInstance->_speedSensorRightCount++;
+  motorControllerInstance->_speedSensorRightTime = millis();
   if (debugShowSpeedSensor)
   {
     Serial.print("_speedCounterRight_ISR: ");
@@ -0,0 +1,71 @@
+#include "PowerController.h"
+
+// The native unit tests sleep with the stub in test/stubs/avr/sleep.h
+#if defined(__AVR__) || defined(UNIT_TEST)
+#define CPU_SLEEP
+#include <avr/sleep.h>
+#endif
+
+PowerController::PowerController()
+{
+  _sleep = true;
+}
+
+void PowerController::setup()
+{
+#ifdef CPU_SLEEP
+  set_sleep_mode(SLEEP_MODE_IDLE);
+#endif
+  resetStatistics();
+}
+
+void PowerController::setSleep(bool enabled)
+{
+  _sleep = enabled;
+}
+
+void PowerController::idle()
+{
+  if (!_sleep)
+    return;
+
+#ifdef CPU_SLEEP
+  unsigned long start = micros();
+  sleep_mode();
+  _addSleepTime(micros() - start);
+#endif
+}
+
+void PowerController::delay(unsigned long milliseconds)
+{
+  unsigned long start = millis();
+  while (millis() - start < milliseconds)
+    idle();
+}
+
+unsigned long PowerController::getSleepMillis()
+{
+  return _sleepMillis;
+}
+
+unsigned long PowerController::getBusyMillis()
+{
+  return millis() - _startTime - _sleepMillis;
+}
+
+void PowerController::_addSleepTime(unsigned long microseconds)
+{
+  _sleepMicros += microseconds;
+  if (_sleepMicros >= 1000)
+  {
+    _sleepMillis += _sleepMicros / 1000;
+    _sleepMicros %= 1000;
+  }
+}
+
+void PowerController::resetStatistics()
+{
+  _startTime = millis();
+  _sleepMillis = 0;
+  _sleepMicros = 0;
+}
@@ -20,5 +20,5 @@ void ServoController::setup()
 void ServoController::setAngle(int angle)
 {
   _servo.write(constrain(angle, 0, 180));
-  delay(1000);
+  powerController.delay(1000);
 }
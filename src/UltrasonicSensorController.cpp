@@ -1,11 +1,23 @@
 #include "UltrasonicSensorController.h"
+#include "EventController.h"
+#include "PowerController.h"
+
+#if defined(__AVR__) && !defined(BFE_NO_PIN_CHANGE_INTERRUPT)
+#define ECHO_PIN_CHANGE_INTERRUPT
+#endif
 
 UltrasonicSensorController *UltrasonicSensorControllerInstance;
 
+const unsigned long echoTimeout = 1000000;   // Same timeout as the default of pulseIn() in microseconds
+const unsigned long measureInterval = 60000; // Measurement cycle of the sensor in microseconds, longer than any echo
+
 UltrasonicSensorController::UltrasonicSensorController(int echo, int trig)
 {
   _echo = echo;
   _trig = trig;
+  _echoInterrupt = false;
+  _measuring = false;
+  _measureStart = 0;
   UltrasonicSensorControllerInstance = this;
 }
 
@@ -13,14 +25,106 @@ void UltrasonicSensorController::setup()
 {
   pinMode(_echo, INPUT);
   pinMode(_trig, OUTPUT);
+  _measuring = false;
+  _measureStart = micros() - measureInterval;
+
+#ifdef ECHO_PIN_CHANGE_INTERRUPT
+  // Only the vector of pins 8 to 13 is defined, other echo pins are timed with pulseIn()
+  _echoInterrupt = digitalPinToPCICRbit(_echo) == PCIE0;
+  if (_echoInterrupt)
+  {
+    *digitalPinToPCMSK(_echo) |= _BV(digitalPinToPCMSKbit(_echo));
+    *digitalPinToPCICR(_echo) |= _BV(digitalPinToPCICRbit(_echo));
+  }
+#endif
 }
 
 unsigned long UltrasonicSensorController::getDistance()
 {
+  _measuring = false;
+  digitalWrite(_trig, 1);
+  powerController.delay(10);
+  _echoStarted = false;
+  _echoComplete = false;
+  digitalWrite(_trig, 0);
+  return _reportDistance(_waitForEcho());
+}
+
+void UltrasonicSensorController::update()
+{
+  if (!_echoInterrupt)
+    return;
+
+  if (_measuring && _echoComplete)
+  {
+    noInterrupts();
+    unsigned long duration = _echoDuration;
+    interrupts();
+    _measuring = false;
+    _reportDistance(duration);
+  }
+
+  unsigned long now = micros();
+  if (now - _measureStart < measureInterval)
+    return;
+
+  // A measurement without an echo by now is dropped, nothing was in range
+  _measureStart = now;
+  _measuring = true;
   digitalWrite(_trig, 1);
-  delay(10);
+  delayMicroseconds(10);
+  _echoStarted = false;
+  _echoComplete = false;
   digitalWrite(_trig, 0);
-  unsigned long duration = pulseIn(_echo, 1);
+}
+
+unsigned long UltrasonicSensorController::_waitForEcho()
+{
+  if (!_echoInterrupt)
+    return pulseIn(_echo, 1);
+
+  unsigned long start = micros();
+  while (!_echoComplete && micros() - start < echoTimeout)
+    powerController.idle();
+
+  noInterrupts();
+  unsigned long duration = _echoComplete ? _echoDuration : 0;
+  interrupts();
+  return duration;
+}
+
+unsigned long UltrasonicSensorController::_reportDistance(unsigned long duration)
+{
   unsigned long distance = duration * 0.034 / 2;
+
+  // Without an echo nothing is in range, so there is no distance to report
+  if (duration != 0)
+    eventController.emit(EventController::DISTANCE_BELOW, distance);
   return distance;
 }
+
+void UltrasonicSensorController::echoChanged_ISR()
+{
+  UltrasonicSensorController *sensor = UltrasonicSensorControllerInstance;
+  if (sensor->_echoComplete)
+    return;
+
+  unsigned long now = micros();
+  if (digitalRead(sensor->_echo))
+  {
+    sensor->_echoStart = now;
+    sensor->_echoStarted = true;
+  }
+  else if (sensor->_echoStarted)
+  {
+    sensor->_echoDuration = now - sensor->_echoStart;
+    sensor->_echoComplete = true;
+  }
+}
+
+#ifdef ECHO_PIN_CHANGE_INTERRUPT
+ISR(PCINT0_vect)
+{
+  UltrasonicSensorController::echoChanged_ISR();
+}
+#endif
@@ -0,0 +1,144 @@
+/**
+ * @file Arduino.h
+ * @brief Host stand-in for the Arduino core used by the native unit tests and benchmarks.
+ *
+ * Only the parts of the Arduino API that the framework uses are provided. Pin writes are recorded, the clock
+ * is controlled by the test and attached interrupt service routines can be triggered by hand through the
+ * ArduinoStub namespace.
+ */
+
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <math.h>
+#include <stdlib.h>
+
+#define LOW 0x0
+#define HIGH 0x1
+
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+
+#define FALLING 2
+
+#define A0 14
+#define A1 15
+#define A2 16
+#define A3 17
+#define A4 18
+#define A5 19
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+template <typename T>
+T max(T a, T b) { return a > b ? a : b; }
+
+template <typename T>
+T min(T a, T b) { return a < b ? a : b; }
+
+namespace ArduinoStub
+{
+  const int PIN_COUNT = 20; ///< Number of digital pins of an Arduino Uno.
+
+  inline unsigned long currentMillis = 0;         ///< Value returned by the next millis() call.
+  inline unsigned long currentMicros = 0;         ///< Microseconds since currentMillis, below 1000.
+  inline unsigned long millisStep = 0;            ///< Added to currentMillis after each millis() call so busy loops make progress.
+  inline unsigned long sleepMicros = 0;           ///< Time that passes during each sleep_mode() call of avr/sleep.h.
+  inline unsigned long pulseDuration = 0;         ///< Value returned by pulseIn().
+  inline int digitalValues[PIN_COUNT];            ///< Last value written with digitalWrite().
+  inline int analogValues[PIN_COUNT];             ///< Last value written with analogWrite().
+  inline void (*interruptHandlers[PIN_COUNT])(); ///< Routines registered with attachInterrupt().
+  inline unsigned long serialCalls = 0;          ///< Number of Serial print calls.
+  inline unsigned long delayCalls = 0;           ///< Number of delay() calls.
+  inline unsigned long pulseInCalls = 0;         ///< Number of pulseIn() calls.
+
+  /**
+   * Resets the clock, all recorded pin values and registered interrupt routines.
+   */
+  inline void reset()
+  {
+    currentMillis = 0;
+    currentMicros = 0;
+    millisStep = 0;
+    sleepMicros = 0;
+    pulseDuration = 0;
+    serialCalls = 0;
+    delayCalls = 0;
+    pulseInCalls = 0;
+    for (int i = 0; i < PIN_COUNT; i++)
+    {
+      digitalValues[i] = 0;
+      analogValues[i] = 0;
+      interruptHandlers[i] = nullptr;
+    }
+  }
+
+  /**
+   * Advances the clock by a number of microseconds.
+   */
+  inline void advanceMicros(unsigned long micros)
+  {
+    currentMicros += micros;
+    currentMillis += currentMicros / 1000;
+    currentMicros %= 1000;
+  }
+
+  /**
+   * Calls the interrupt service routine attached to a pin, like an edge on that pin would.
+   */
+  inline void triggerInterrupt(int pin)
+  {
+    if (interruptHandlers[pin] != nullptr)
+      interruptHandlers[pin]();
+  }
+}
+
+inline unsigned long millis()
+{
+  unsigned long now = ArduinoStub::currentMillis;
+  ArduinoStub::currentMillis += ArduinoStub::millisStep;
+  return now;
+}
+
+inline unsigned long micros() { return ArduinoStub::currentMillis * 1000 + ArduinoStub::currentMicros; }
+inline void delay(unsigned long ms)
+{
+  ArduinoStub::delayCalls++;
+  ArduinoStub::currentMillis += ms;
+}
+
+inline void delayMicroseconds(unsigned int) {}
+
+inline void pinMode(int, int) {}
+inline void digitalWrite(int pin, int value) { ArduinoStub::digitalValues[pin] = value; }
+inline int digitalRead(int pin) { return ArduinoStub::digitalValues[pin]; }
+inline void analogWrite(int pin, int value) { ArduinoStub::analogValues[pin] = value; }
+inline unsigned long pulseIn(int, int)
+{
+  ArduinoStub::pulseInCalls++;
+  return ArduinoStub::pulseDuration;
+}
+
+inline int digitalPinToInterrupt(int pin) { return pin; }
+inline void attachInterrupt(int interrupt, void (*handler)(), int) { ArduinoStub::interruptHandlers[interrupt] = handler; }
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+/**
+ * Serial port that counts and discards everything written to it.
+ */
+class HardwareSerial
+{
+public:
+  void begin(unsigned long) {}
+  template <typename T>
+  void print(T) { ArduinoStub::serialCalls++; }
+  template <typename T>
+  void println(T) { ArduinoStub::serialCalls++; }
+  void println() { ArduinoStub::serialCalls++; }
+};
+
+inline HardwareSerial Serial;
+
+#endif
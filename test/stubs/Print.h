@@ -0,0 +1,7 @@
+#ifndef Print_h
+#define Print_h
+
+// Print is part of Arduino.h in this stub.
+#include "Arduino.h"
+
+#endif
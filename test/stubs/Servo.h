@@ -0,0 +1,19 @@
+#ifndef Servo_h
+#define Servo_h
+
+/**
+ * Host stand-in for the Arduino Servo library that remembers the last written angle.
+ */
+class Servo
+{
+public:
+  void attach(int pin) { _pin = pin; }
+  void write(int angle) { _angle = angle; }
+  int read() { return _angle; }
+
+private:
+  int _pin = -1;
+  int _angle = 0;
+};
+
+#endif
@@ -0,0 +1,16 @@
+#ifndef avr_sleep_h
+#define avr_sleep_h
+
+#include "Arduino.h"
+
+/**
+ * Host stand-in for the AVR sleep functions. Sleeping advances the stub clock by ArduinoStub::sleepMicros,
+ * like the time until the next interrupt would pass on the Arduino.
+ */
+
+#define SLEEP_MODE_IDLE 0
+
+inline void set_sleep_mode(int) {}
+inline void sleep_mode() { ArduinoStub::advanceMicros(ArduinoStub::sleepMicros); }
+
+#endif
@@ -0,0 +1,153 @@
+#include <unity.h>
+#include "BFEArduinoRobotFramework.h"
+
+// ADC samples for battery voltages with a divider ratio of 3
+const unsigned int sampleNominal = 505;   // 7.40V
+const unsigned int sampleLow = 409;       // 6.00V
+const unsigned int sampleRecovered = 470; // 6.89V
+
+int lowBatteryEvents;
+long lastMillivolts;
+
+void onLowBattery(EventController::Event, long value)
+{
+  lowBatteryEvents++;
+  lastMillivolts = value;
+}
+
+void addReading(unsigned int sample)
+{
+  for (int i = 0; i < BatteryController::SAMPLES_PER_READING; i++)
+    batteryController.addSample(sample);
+}
+
+void setUp()
+{
+  ArduinoStub::reset();
+  eventController.setup();
+  batteryController.setup();
+  batteryController.begin(A0, 3.0);
+  lowBatteryEvents = 0;
+  lastMillivolts = 0;
+}
+
+void tearDown() {}
+
+void test_no_reading_keeps_speed()
+{
+  TEST_ASSERT_FLOAT_WITHIN(0.001, 0.0, batteryController.getVoltage());
+  TEST_ASSERT_EQUAL_INT(150, batteryController.compensate(150));
+}
+
+void test_voltage_is_averaged_from_samples()
+{
+  for (int i = 0; i < BatteryController::SAMPLES_PER_READING - 1; i++)
+    batteryController.addSample(sampleNominal);
+  TEST_ASSERT_FLOAT_WITHIN(0.001, 0.0, batteryController.getVoltage());
+
+  batteryController.addSample(sampleNominal);
+  TEST_ASSERT_FLOAT_WITHIN(0.01, 7.40, batteryController.getVoltage());
+}
+
+void test_compensation_follows_voltage()
+{
+  addReading(sampleNominal);
+  TEST_ASSERT_EQUAL_INT(149, batteryController.compensate(150));
+
+  addReading(sampleLow);
+  TEST_ASSERT_EQUAL_INT(184, batteryController.compensate(150));
+  TEST_ASSERT_EQUAL_INT(255, batteryController.compensate(255));
+  TEST_ASSERT_EQUAL_INT(0, batteryController.compensate(0));
+
+  batteryController.setCompensation(false);
+  TEST_ASSERT_EQUAL_INT(150, batteryController.compensate(150));
+}
+
+void test_disconnected_divider_keeps_speed()
+{
+  addReading(0);
+  TEST_ASSERT_EQUAL_INT(150, batteryController.compensate(150));
+  TEST_ASSERT_FALSE(batteryController.isLowBattery());
+}
+
+void test_low_battery_event_with_hysteresis()
+{
+  eventController.subscribe(EventController::LOW_BATTERY, onLowBattery);
+
+  addReading(sampleLow);
+  TEST_ASSERT_TRUE(batteryController.isLowBattery());
+  addReading(sampleLow);
+  batteryController.isLowBattery();
+  eventController.dispatch();
+  TEST_ASSERT_EQUAL_INT(1, lowBatteryEvents);
+  TEST_ASSERT_INT32_WITHIN(10, 6000, lastMillivolts);
+
+  addReading(sampleRecovered);
+  TEST_ASSERT_FALSE(batteryController.isLowBattery());
+  addReading(sampleLow);
+  batteryController.isLowBattery();
+  eventController.dispatch();
+  TEST_ASSERT_EQUAL_INT(2, lowBatteryEvents);
+}
+
+void test_dispatch_emits_low_battery()
+{
+  eventController.subscribe(EventController::LOW_BATTERY, onLowBattery);
+
+  // No motor command and no battery query, only the loop calling dispatch()
+  addReading(sampleLow);
+  eventController.dispatch();
+  TEST_ASSERT_EQUAL_INT(1, lowBatteryEvents);
+  TEST_ASSERT_INT32_WITHIN(10, 6000, lastMillivolts);
+}
+
+void test_no_compensation_without_begin()
+{
+  batteryController.end();
+  batteryController.setup();
+  addReading(sampleLow);
+  TEST_ASSERT_FLOAT_WITHIN(0.001, 0.0, batteryController.getVoltage());
+  TEST_ASSERT_EQUAL_INT(150, batteryController.compensate(150));
+  TEST_ASSERT_FALSE(batteryController.isLowBattery());
+}
+
+void test_end_stops_compensation()
+{
+  addReading(sampleLow);
+  TEST_ASSERT_EQUAL_INT(184, batteryController.compensate(150));
+
+  batteryController.end();
+  TEST_ASSERT_EQUAL_INT(150, batteryController.compensate(150));
+  TEST_ASSERT_FALSE(batteryController.isLowBattery());
+  addReading(sampleLow);
+  TEST_ASSERT_EQUAL_INT(150, batteryController.compensate(150));
+
+  batteryController.setCompensation(true);
+  addReading(sampleLow);
+  TEST_ASSERT_EQUAL_INT(184, batteryController.compensate(150));
+}
+
+void test_motor_output_is_compensated()
+{
+  addReading(sampleLow);
+  motorController.setup();
+  motorController.setDirection(MotorController::FORWARD);
+  motorController.drive();
+  TEST_ASSERT_EQUAL_INT(184, ArduinoStub::analogValues[6]);
+  TEST_ASSERT_EQUAL_INT(184, ArduinoStub::analogValues[5]);
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_no_reading_keeps_speed);
+  RUN_TEST(test_voltage_is_averaged_from_samples);
+  RUN_TEST(test_compensation_follows_voltage);
+  RUN_TEST(test_disconnected_divider_keeps_speed);
+  RUN_TEST(test_low_battery_event_with_hysteresis);
+  RUN_TEST(test_dispatch_emits_low_battery);
+  RUN_TEST(test_no_compensation_without_begin);
+  RUN_TEST(test_end_stops_compensation);
+  RUN_TEST(test_motor_output_is_compensated);
+  return UNITY_END();
+}
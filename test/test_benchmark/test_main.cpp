@@ -0,0 +1,156 @@
+/**
+ * Microbenchmarks for the code that runs on every loop iteration, encoder hole or battery ADC sample.
+ *
+ * Each benchmark reports the fastest of several runs in nanoseconds per call. Absolute times depend on the
+ * machine and its load, so instead of a fixed time budget, a small reference workload is timed the same way right
+ * before each benchmark and the budget is a multiple of its time. The budgets are about three times the ratios
+ * measured on a host (drive() 20-28x, _calcSpeedError() 3-5x, speed sensor ISRs 1.2-2x, addSample() 0.7-1.2x),
+ * so a several-fold slowdown fails while a slow or busy CI machine doesn't. They are host numbers, not Arduino
+ * numbers, and can be adjusted with build flags, e.g. -D BENCHMARK_DRIVE_BUDGET=100.
+ *
+ * The stub Serial, delay() and pulseIn() return immediately, so their cost doesn't show up in the timings.
+ * Instead every benchmark fails if the measured code called them at all.
+ */
+
+#include <unity.h>
+#include <chrono>
+#include <stdio.h>
+#include "BFEArduinoRobotFramework.h"
+
+#ifndef BENCHMARK_DRIVE_BUDGET
+#define BENCHMARK_DRIVE_BUDGET 80.0
+#endif
+
+#ifndef BENCHMARK_SPEED_ERROR_BUDGET
+#define BENCHMARK_SPEED_ERROR_BUDGET 15.0
+#endif
+
+#ifndef BENCHMARK_ISR_BUDGET
+#define BENCHMARK_ISR_BUDGET 6.0
+#endif
+
+#ifndef BENCHMARK_SAMPLE_BUDGET
+#define BENCHMARK_SAMPLE_BUDGET 4.0
+#endif
+
+const int speedSensorLeft = 2;  // Pin of the left speed sensor as wired in BFEArduinoRobotFramework.cpp
+const int speedSensorRight = 3; // Pin of the right speed sensor as wired in BFEArduinoRobotFramework.cpp
+const int runs = 5;
+const int iterations = 100000;
+
+struct MotorControllerTestAccess
+{
+  static void calcSpeedError() { motorController._calcSpeedError(); }
+};
+
+template <typename Function>
+double nanosecondsPerCall(Function function)
+{
+  double best = 0;
+  for (int run = 0; run < runs; run++)
+  {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+      function();
+    auto end = std::chrono::steady_clock::now();
+
+    double nanoseconds = std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+    if (run == 0 || nanoseconds < best)
+      best = nanoseconds;
+  }
+  return best;
+}
+
+volatile unsigned long calibrationCounter;
+volatile float calibrationValue;
+
+/**
+ * Fixed reference workload: a few volatile loads and stores and a float multiply-add, like the framework code.
+ */
+void calibrationWork()
+{
+  calibrationCounter = calibrationCounter + 1;
+  calibrationValue = calibrationValue * 0.5f + 1.0f;
+}
+
+template <typename Function>
+void measure(const char *name, Function function, double budget)
+{
+  // The reference runs right before the measured code, so both see the same machine and load
+  double reference = nanosecondsPerCall(calibrationWork);
+  double nanoseconds = nanosecondsPerCall(function);
+  double ratio = nanoseconds / reference;
+
+  char message[128];
+  snprintf(message, sizeof(message), "%s: %.1f ns/call = %.1fx reference (budget %.1fx)", name, nanoseconds, ratio, budget);
+  TEST_MESSAGE(message);
+  TEST_ASSERT_TRUE_MESSAGE(ratio <= budget, message);
+  TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, ArduinoStub::serialCalls, name);
+  TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, ArduinoStub::delayCalls, name);
+  TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, ArduinoStub::pulseInCalls, name);
+}
+void setUp()
+{
+  ArduinoStub::reset();
+  eventController.setup();
+  motorController.setup();
+
+  // Every millis() call advances the clock so the speed error calculation never takes its early return
+  ArduinoStub::millisStep = 1;
+}
+
+void tearDown() {}
+
+void batterySample()
+{
+  batteryController.addSample(500);
+}
+
+void driveWithEncoderHoles()
+{
+  ArduinoStub::triggerInterrupt(speedSensorLeft);
+  ArduinoStub::triggerInterrupt(speedSensorRight);
+  motorController.drive();
+}
+
+void speedSensorLeftEdge()
+{
+  ArduinoStub::triggerInterrupt(speedSensorLeft);
+}
+
+void speedSensorRightEdge()
+{
+  ArduinoStub::triggerInterrupt(speedSensorRight);
+}
+
+void benchmark_drive()
+{
+  motorController.setDirection(MotorController::FORWARD);
+  measure("drive()", driveWithEncoderHoles, BENCHMARK_DRIVE_BUDGET);
+}
+
+void benchmark_calc_speed_error()
+{
+  measure("_calcSpeedError()", MotorControllerTestAccess::calcSpeedError, BENCHMARK_SPEED_ERROR_BUDGET);
+}
+
+void benchmark_speed_sensor_isr()
+{
+  measure("_speedCounterLeft_ISR()", speedSensorLeftEdge, BENCHMARK_ISR_BUDGET);
+  measure("_speedCounterRight_ISR()", speedSensorRightEdge, BENCHMARK_ISR_BUDGET);
+}
+
+void benchmark_battery_sample()
+{
+  measure("BatteryController::addSample()", batterySample, BENCHMARK_SAMPLE_BUDGET);
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(benchmark_drive);
+  RUN_TEST(benchmark_calc_speed_error);
+  RUN_TEST(benchmark_speed_sensor_isr);
+  RUN_TEST(benchmark_battery_sample);
+  return UNITY_END();
+}
@@ -0,0 +1,85 @@
+#include <unity.h>
+#include "EventController.h"
+
+EventController events;
+
+int callCount;
+long lastValue;
+
+void onEvent(EventController::Event, long value)
+{
+  callCount++;
+  lastValue = value;
+}
+
+void setUp()
+{
+  events.setup();
+  callCount = 0;
+  lastValue = 0;
+}
+
+void tearDown() {}
+
+void test_dispatch_calls_subscriber()
+{
+  events.subscribe(EventController::TURN_COMPLETE, onEvent);
+  events.emit(EventController::TURN_COMPLETE, 90);
+  TEST_ASSERT_EQUAL_INT(0, callCount);
+
+  events.dispatch();
+  TEST_ASSERT_EQUAL_INT(1, callCount);
+  TEST_ASSERT_EQUAL_INT32(90, lastValue);
+
+  events.dispatch();
+  TEST_ASSERT_EQUAL_INT(1, callCount);
+}
+
+void test_other_events_are_ignored()
+{
+  events.subscribe(EventController::TURN_COMPLETE, onEvent);
+  events.emit(EventController::MOVE_COMPLETE, 20);
+  events.dispatch();
+  TEST_ASSERT_EQUAL_INT(0, callCount);
+}
+
+void test_unsubscribe()
+{
+  int id = events.subscribe(EventController::WHEEL_STALL, onEvent);
+  events.unsubscribe(id);
+  events.emit(EventController::WHEEL_STALL);
+  events.dispatch();
+  TEST_ASSERT_EQUAL_INT(0, callCount);
+}
+
+void test_subscriber_slots_are_bounded()
+{
+  for (int i = 0; i < EventController::MAX_SUBSCRIBERS; i++)
+    TEST_ASSERT_EQUAL_INT(i, events.subscribe(EventController::TURN_COMPLETE, onEvent));
+  TEST_ASSERT_EQUAL_INT(-1, events.subscribe(EventController::TURN_COMPLETE, onEvent));
+
+  events.unsubscribe(3);
+  TEST_ASSERT_EQUAL_INT(3, events.subscribe(EventController::TURN_COMPLETE, onEvent));
+}
+
+void test_full_queue_drops_oldest_event()
+{
+  events.subscribe(EventController::MOVE_COMPLETE, onEvent);
+  for (int i = 1; i <= EventController::MAX_PENDING_EVENTS + 2; i++)
+    events.emit(EventController::MOVE_COMPLETE, i);
+
+  events.dispatch();
+  TEST_ASSERT_EQUAL_INT(EventController::MAX_PENDING_EVENTS, callCount);
+  TEST_ASSERT_EQUAL_INT32(EventController::MAX_PENDING_EVENTS + 2, lastValue);
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_dispatch_calls_subscriber);
+  RUN_TEST(test_other_events_are_ignored);
+  RUN_TEST(test_unsubscribe);
+  RUN_TEST(test_subscriber_slots_are_bounded);
+  RUN_TEST(test_full_queue_drops_oldest_event);
+  return UNITY_END();
+}
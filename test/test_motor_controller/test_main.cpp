@@ -0,0 +1,235 @@
+#include <unity.h>
+#include "BFEArduinoRobotFramework.h"
+
+// Pins as wired in BFEArduinoRobotFramework.cpp
+const int enA = 6;
+const int enB = 5;
+const int speedSensorLeft = 2;
+const int speedSensorRight = 3;
+
+struct MotorControllerTestAccess
+{
+  static int holesForDegrees(int degrees) { return motorController._holesForDegrees(degrees); }
+
+  static float calcSpeedError()
+  {
+    motorController._calcSpeedError();
+    return motorController._speedError;
+  }
+};
+
+int stallEvents;
+int turnCompleteEvents;
+long lastTurnDegrees;
+int moveCompleteEvents;
+long lastMoveHoles;
+
+void onStall(EventController::Event, long)
+{
+  stallEvents++;
+}
+
+void onTurnComplete(EventController::Event, long value)
+{
+  turnCompleteEvents++;
+  lastTurnDegrees = value;
+}
+
+void onMoveComplete(EventController::Event, long value)
+{
+  moveCompleteEvents++;
+  lastMoveHoles = value;
+}
+
+void triggerHoles(int pin, int count)
+{
+  for (int i = 0; i < count; i++)
+    ArduinoStub::triggerInterrupt(pin);
+}
+
+void setUp()
+{
+  ArduinoStub::reset();
+  ArduinoStub::currentMillis = 1000;
+  eventController.setup();
+  motorController.setup();
+  stallEvents = 0;
+  turnCompleteEvents = 0;
+  lastTurnDegrees = 0;
+  moveCompleteEvents = 0;
+  lastMoveHoles = -1;
+}
+
+void tearDown() {}
+
+void test_holes_for_degrees()
+{
+  TEST_ASSERT_EQUAL_INT(0, MotorControllerTestAccess::holesForDegrees(0));
+  TEST_ASSERT_EQUAL_INT(1, MotorControllerTestAccess::holesForDegrees(10));
+  TEST_ASSERT_EQUAL_INT(5, MotorControllerTestAccess::holesForDegrees(45));
+  TEST_ASSERT_EQUAL_INT(10, MotorControllerTestAccess::holesForDegrees(90));
+  TEST_ASSERT_EQUAL_INT(20, MotorControllerTestAccess::holesForDegrees(180));
+  TEST_ASSERT_EQUAL_INT(40, MotorControllerTestAccess::holesForDegrees(360));
+}
+
+void test_speed_error_is_zero_for_equal_wheels()
+{
+  triggerHoles(speedSensorLeft, 5);
+  triggerHoles(speedSensorRight, 5);
+  ArduinoStub::currentMillis += 100;
+  TEST_ASSERT_FLOAT_WITHIN(0.001, 0.0, MotorControllerTestAccess::calcSpeedError());
+}
+
+void test_speed_error_follows_faster_wheel()
+{
+  // 5 holes in 100ms = 2.5 turns per second = 50% of the maximum speed, scaled by 255 * 2 over 0.1s
+  triggerHoles(speedSensorLeft, 5);
+  ArduinoStub::currentMillis += 100;
+  TEST_ASSERT_FLOAT_WITHIN(0.001, 25.5, MotorControllerTestAccess::calcSpeedError());
+
+  triggerHoles(speedSensorRight, 10);
+  ArduinoStub::currentMillis += 100;
+  TEST_ASSERT_FLOAT_WITHIN(0.001, -25.5, MotorControllerTestAccess::calcSpeedError());
+}
+
+void test_speed_error_ignores_zero_time_delta()
+{
+  triggerHoles(speedSensorLeft, 5);
+  TEST_ASSERT_FLOAT_WITHIN(0.001, 0.0, MotorControllerTestAccess::calcSpeedError());
+}
+
+void test_drive_applies_speed_error()
+{
+  triggerHoles(speedSensorLeft, 5);
+  ArduinoStub::currentMillis += 100;
+  MotorControllerTestAccess::calcSpeedError();
+
+  motorController.setDirection(MotorController::FORWARD);
+  motorController.setSpeed(150);
+  motorController.drive();
+
+  TEST_ASSERT_EQUAL_INT(124, ArduinoStub::analogValues[enA]);
+  TEST_ASSERT_EQUAL_INT(175, ArduinoStub::analogValues[enB]);
+}
+
+void test_drive_stops_stalled_wheel()
+{
+  eventController.subscribe(EventController::WHEEL_STALL, onStall);
+  motorController.setDirection(MotorController::FORWARD);
+  motorController.drive();
+
+  for (int i = 0; i < 30; i++)
+  {
+    ArduinoStub::currentMillis += 10;
+    ArduinoStub::triggerInterrupt(speedSensorLeft);
+    motorController.drive();
+  }
+  eventController.dispatch();
+
+  TEST_ASSERT_EQUAL_INT(1, stallEvents);
+  TEST_ASSERT_NOT_EQUAL(0, ArduinoStub::analogValues[enA]);
+  TEST_ASSERT_EQUAL_INT(0, ArduinoStub::analogValues[enB]);
+}
+
+void test_clearing_stall_resets_speed_error()
+{
+  motorController.setDirection(MotorController::FORWARD);
+  motorController.drive();
+
+  for (int i = 0; i < 30; i++)
+  {
+    ArduinoStub::currentMillis += 10;
+    ArduinoStub::triggerInterrupt(speedSensorLeft);
+    motorController.drive();
+  }
+  TEST_ASSERT_EQUAL_INT(0, ArduinoStub::analogValues[enB]);
+
+  ArduinoStub::currentMillis += 10;
+  motorController.setDirection(MotorController::FORWARD);
+  ArduinoStub::currentMillis += 10;
+  motorController.drive();
+
+  TEST_ASSERT_FLOAT_WITHIN(0.001, 0.0, MotorControllerTestAccess::calcSpeedError());
+  TEST_ASSERT_EQUAL_INT(150, ArduinoStub::analogValues[enA]);
+  TEST_ASSERT_EQUAL_INT(150, ArduinoStub::analogValues[enB]);
+}
+
+void test_direction_change_restarts_stall_timeout()
+{
+  eventController.subscribe(EventController::WHEEL_STALL, onStall);
+  motorController.setDirection(MotorController::FORWARD);
+  motorController.drive();
+
+  for (int i = 0; i < 20; i++)
+  {
+    ArduinoStub::currentMillis += 10;
+    triggerHoles(speedSensorLeft, 1);
+    triggerHoles(speedSensorRight, 1);
+    motorController.drive();
+  }
+
+  // The wheels slow down without a hole, then have to spin up backward
+  ArduinoStub::currentMillis += 150;
+  motorController.drive();
+  motorController.setDirection(MotorController::BACKWARD);
+  for (int i = 0; i < 19; i++)
+  {
+    ArduinoStub::currentMillis += 10;
+    motorController.drive();
+  }
+  eventController.dispatch();
+
+  TEST_ASSERT_EQUAL_INT(0, stallEvents);
+  TEST_ASSERT_NOT_EQUAL(0, ArduinoStub::analogValues[enA]);
+  TEST_ASSERT_NOT_EQUAL(0, ArduinoStub::analogValues[enB]);
+
+  // Without a hole the wheels still stall once the timeout has passed since the direction change
+  ArduinoStub::currentMillis += 30;
+  motorController.drive();
+  eventController.dispatch();
+  TEST_ASSERT_EQUAL_INT(2, stallEvents);
+}
+
+void test_turn_ends_when_wheels_stall()
+{
+  eventController.subscribe(EventController::WHEEL_STALL, onStall);
+  eventController.subscribe(EventController::TURN_COMPLETE, onTurnComplete);
+  ArduinoStub::millisStep = 1;
+
+  motorController.leftTurn(90);
+  eventController.dispatch();
+
+  TEST_ASSERT_EQUAL_INT(2, stallEvents);
+  TEST_ASSERT_EQUAL_INT(1, turnCompleteEvents);
+  TEST_ASSERT_EQUAL_INT(0, lastTurnDegrees);
+  TEST_ASSERT_EQUAL_INT(0, ArduinoStub::analogValues[enA]);
+  TEST_ASSERT_EQUAL_INT(0, ArduinoStub::analogValues[enB]);
+}
+
+void test_move_reports_covered_holes_after_stall()
+{
+  eventController.subscribe(EventController::MOVE_COMPLETE, onMoveComplete);
+  ArduinoStub::millisStep = 1;
+
+  motorController.move(-20);
+  eventController.dispatch();
+
+  TEST_ASSERT_EQUAL_INT(1, moveCompleteEvents);
+  TEST_ASSERT_EQUAL_INT(0, lastMoveHoles);
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_holes_for_degrees);
+  RUN_TEST(test_speed_error_is_zero_for_equal_wheels);
+  RUN_TEST(test_speed_error_follows_faster_wheel);
+  RUN_TEST(test_speed_error_ignores_zero_time_delta);
+  RUN_TEST(test_drive_applies_speed_error);
+  RUN_TEST(test_drive_stops_stalled_wheel);
+  RUN_TEST(test_clearing_stall_resets_speed_error);
+  RUN_TEST(test_direction_change_restarts_stall_timeout);
+  RUN_TEST(test_turn_ends_when_wheels_stall);
+  RUN_TEST(test_move_reports_covered_holes_after_stall);
+  return UNITY_END();
+}
@@ -0,0 +1,85 @@
+#include <unity.h>
+#include "BFEArduinoRobotFramework.h"
+
+void setUp()
+{
+  ArduinoStub::reset();
+  ArduinoStub::currentMillis = 1000;
+  powerController.setup();
+}
+
+void tearDown() {}
+
+void test_delay_waits_for_time()
+{
+  ArduinoStub::millisStep = 1;
+  powerController.delay(50);
+  TEST_ASSERT_GREATER_OR_EQUAL_UINT32(1050, ArduinoStub::currentMillis);
+  TEST_ASSERT_LESS_THAN_UINT32(1060, ArduinoStub::currentMillis);
+}
+
+void test_delay_of_zero_returns()
+{
+  powerController.delay(0);
+  TEST_ASSERT_EQUAL_UINT32(1000, ArduinoStub::currentMillis);
+}
+
+void test_busy_time_without_sleep()
+{
+  ArduinoStub::currentMillis += 250;
+  TEST_ASSERT_EQUAL_UINT32(0, powerController.getSleepMillis());
+  TEST_ASSERT_EQUAL_UINT32(250, powerController.getBusyMillis());
+
+  powerController.resetStatistics();
+  TEST_ASSERT_EQUAL_UINT32(0, powerController.getBusyMillis());
+}
+
+void test_sleep_time_carries_microseconds()
+{
+  ArduinoStub::sleepMicros = 400;
+
+  for (int i = 0; i < 3; i++)
+    powerController.idle();
+  TEST_ASSERT_EQUAL_UINT32(1, powerController.getSleepMillis());
+  TEST_ASSERT_EQUAL_UINT32(0, powerController.getBusyMillis());
+
+  // The 200us left over from the first millisecond count towards the next one
+  for (int i = 0; i < 2; i++)
+    powerController.idle();
+  TEST_ASSERT_EQUAL_UINT32(2, powerController.getSleepMillis());
+  TEST_ASSERT_EQUAL_UINT32(0, powerController.getBusyMillis());
+
+  ArduinoStub::currentMillis += 3;
+  TEST_ASSERT_EQUAL_UINT32(3, powerController.getBusyMillis());
+}
+
+void test_delay_sleeps_whole_time()
+{
+  ArduinoStub::sleepMicros = 1000;
+  powerController.delay(50);
+  TEST_ASSERT_EQUAL_UINT32(1050, ArduinoStub::currentMillis);
+  TEST_ASSERT_EQUAL_UINT32(50, powerController.getSleepMillis());
+  TEST_ASSERT_EQUAL_UINT32(0, powerController.getBusyMillis());
+}
+
+void test_no_sleep_time_when_disabled()
+{
+  ArduinoStub::sleepMicros = 1000;
+  powerController.setSleep(false);
+  powerController.idle();
+  powerController.setSleep(true);
+  TEST_ASSERT_EQUAL_UINT32(1000, ArduinoStub::currentMillis);
+  TEST_ASSERT_EQUAL_UINT32(0, powerController.getSleepMillis());
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_delay_waits_for_time);
+  RUN_TEST(test_delay_of_zero_returns);
+  RUN_TEST(test_busy_time_without_sleep);
+  RUN_TEST(test_sleep_time_carries_microseconds);
+  RUN_TEST(test_delay_sleeps_whole_time);
+  RUN_TEST(test_no_sleep_time_when_disabled);
+  return UNITY_END();
+}
@@ -0,0 +1,150 @@
+#include <unity.h>
+#include "BFEArduinoRobotFramework.h"
+
+const int echo = 9; // Pin of the echo as wired in BFEArduinoRobotFramework.cpp
+
+struct UltrasonicSensorControllerTestAccess
+{
+  static void armEcho()
+  {
+    sensorController._echoStarted = false;
+    sensorController._echoComplete = false;
+  }
+
+  static void useEchoInterrupt() { sensorController._echoInterrupt = true; }
+  static void usePulseIn() { sensorController._echoInterrupt = false; }
+  static bool measuring() { return sensorController._measuring; }
+  static bool echoComplete() { return sensorController._echoComplete; }
+  static unsigned long echoDuration() { return sensorController._echoDuration; }
+};
+
+long lastDistance;
+
+void onDistanceBelow(EventController::Event, long value)
+{
+  lastDistance = value;
+}
+
+void setUp()
+{
+  ArduinoStub::reset();
+  ArduinoStub::millisStep = 1;
+  eventController.setup();
+  sensorController.setup();
+  lastDistance = -1;
+}
+
+void tearDown()
+{
+  UltrasonicSensorControllerTestAccess::usePulseIn();
+}
+
+void test_distance_from_echo_duration()
+{
+  ArduinoStub::pulseDuration = 0;
+  TEST_ASSERT_EQUAL_UINT32(0, sensorController.getDistance());
+
+  // 0.034cm per microsecond, halved for the way to the object and back
+  ArduinoStub::pulseDuration = 580;
+  TEST_ASSERT_EQUAL_UINT32(9, sensorController.getDistance());
+
+  ArduinoStub::pulseDuration = 1000;
+  TEST_ASSERT_EQUAL_UINT32(17, sensorController.getDistance());
+
+  ArduinoStub::pulseDuration = 11765;
+  TEST_ASSERT_EQUAL_UINT32(200, sensorController.getDistance());
+}
+
+void test_distance_below_event()
+{
+  eventController.subscribe(EventController::DISTANCE_BELOW, onDistanceBelow, 10);
+
+  ArduinoStub::pulseDuration = 1000;
+  sensorController.getDistance();
+  eventController.dispatch();
+  TEST_ASSERT_EQUAL_INT32(-1, lastDistance);
+
+  // No echo means nothing is in range, not an obstacle at 0cm
+  ArduinoStub::pulseDuration = 0;
+  sensorController.getDistance();
+  eventController.dispatch();
+  TEST_ASSERT_EQUAL_INT32(-1, lastDistance);
+
+  ArduinoStub::pulseDuration = 300;
+  sensorController.getDistance();
+  eventController.dispatch();
+  TEST_ASSERT_EQUAL_INT32(5, lastDistance);
+}
+
+void setEcho(int value, unsigned long millis)
+{
+  ArduinoStub::digitalValues[echo] = value;
+  ArduinoStub::currentMillis = millis;
+  UltrasonicSensorController::echoChanged_ISR();
+}
+
+void test_echo_interrupt_times_pulse()
+{
+  UltrasonicSensorControllerTestAccess::armEcho();
+
+  // A falling edge before the pulse started is ignored
+  setEcho(0, 1000);
+  TEST_ASSERT_FALSE(UltrasonicSensorControllerTestAccess::echoComplete());
+
+  setEcho(1, 2000);
+  TEST_ASSERT_FALSE(UltrasonicSensorControllerTestAccess::echoComplete());
+
+  setEcho(0, 2002);
+  TEST_ASSERT_TRUE(UltrasonicSensorControllerTestAccess::echoComplete());
+  TEST_ASSERT_EQUAL_UINT32(2000, UltrasonicSensorControllerTestAccess::echoDuration());
+
+  // Once complete, further edges don't change the measured pulse
+  setEcho(1, 2005);
+  setEcho(0, 2010);
+  TEST_ASSERT_TRUE(UltrasonicSensorControllerTestAccess::echoComplete());
+  TEST_ASSERT_EQUAL_UINT32(2000, UltrasonicSensorControllerTestAccess::echoDuration());
+}
+
+void test_dispatch_measures_distance_in_background()
+{
+  UltrasonicSensorControllerTestAccess::useEchoInterrupt();
+  ArduinoStub::millisStep = 0;
+  ArduinoStub::currentMillis = 1000;
+
+  // Nothing is measured while nobody is interested in the distance
+  eventController.dispatch();
+  TEST_ASSERT_FALSE(UltrasonicSensorControllerTestAccess::measuring());
+
+  eventController.subscribe(EventController::DISTANCE_BELOW, onDistanceBelow, 20);
+  eventController.dispatch();
+  TEST_ASSERT_TRUE(UltrasonicSensorControllerTestAccess::measuring());
+  setEcho(1, 1001);
+  eventController.dispatch();
+  TEST_ASSERT_EQUAL_INT32(-1, lastDistance);
+
+  // The echo is picked up by the next dispatch() without waiting for it
+  setEcho(0, 1002);
+  eventController.dispatch();
+  TEST_ASSERT_EQUAL_INT32(17, lastDistance);
+
+  // A measurement without an echo is dropped when the next one starts
+  lastDistance = -1;
+  ArduinoStub::currentMillis = 1060;
+  eventController.dispatch();
+  ArduinoStub::currentMillis = 1120;
+  eventController.dispatch();
+  TEST_ASSERT_EQUAL_INT32(-1, lastDistance);
+
+  TEST_ASSERT_EQUAL_UINT32(0, ArduinoStub::pulseInCalls);
+  TEST_ASSERT_EQUAL_UINT32(0, ArduinoStub::delayCalls);
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_distance_from_echo_duration);
+  RUN_TEST(test_distance_below_event);
+  RUN_TEST(test_echo_interrupt_times_pulse);
+  RUN_TEST(test_dispatch_measures_distance_in_background);
+  return UNITY_END();
+}